@@ -0,0 +1,62 @@
+/*
+    Level file format shared between the game and the LevelAnalyzer tool, so both agree on what a
+    level looks like and which files in the levels directory are actually loaded.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+// Level dimensions - mapHeight is one more than mapWidth to leave room for the score row at the top
+const int mapWidth = 30;
+const int mapHeight = 31;
+
+// Characters that can appear in a level file
+enum LevelChar : char
+{
+    LEVEL_WALL          = '#',
+    LEVEL_FLOOR         = ' ',
+    LEVEL_PLAYER_SPAWN  = 'P',
+    LEVEL_DOOR          = 'D'
+};
+
+/*
+    Matches level<N>.txt, the only names main() will ever try to load. main() builds the name with
+    std::to_string(), so a leading zero (level03.txt) is never loaded and doesn't count. The number is
+    capped at 9 digits so it fits in an int.
+
+    Works on the native name (wide on Windows) rather than filename().string(), which throws for names
+    that don't fit in the ANSI code page.
+*/
+inline bool isLevelFileName(const std::filesystem::path& file, int& levelNumber)
+{
+    const std::string prefix = "level";
+    const std::string suffix = ".txt";
+    std::filesystem::path::string_type fileName = file.filename().native();
+
+    if (fileName.size() <= prefix.size() + suffix.size())
+        return false;
+    for (size_t i = 0; i < prefix.size(); i++)
+        if (fileName[i] != (std::filesystem::path::value_type)prefix[i])
+            return false;
+    for (size_t i = 0; i < suffix.size(); i++)
+        if (fileName[fileName.size() - suffix.size() + i] != (std::filesystem::path::value_type)suffix[i])
+            return false;
+
+    size_t numberStart = prefix.size();
+    size_t numberLength = fileName.size() - prefix.size() - suffix.size();
+    if (numberLength > 9 || (numberLength > 1 && fileName[numberStart] == '0'))
+        return false;
+
+    int number = 0;
+    for (size_t i = numberStart; i < numberStart + numberLength; i++)
+    {
+        if (fileName[i] < '0' || fileName[i] > '9')
+            return false;
+        number = number * 10 + (int)(fileName[i] - '0');
+    }
+
+    levelNumber = number;
+    return true;
+}
@@ -0,0 +1,804 @@
+/*
+    Endless PacMan Level Analyzer
+
+    A command line tool for checking level files before they get anywhere near the game. initMap() will happily
+    load anything it's given and just glue the lines together, so a short line, a stray '\r' in the middle of a
+    row or a missing spawn point only shows up as a broken level mid-game. This tool loads levels the same
+    way the game does and checks them properly.
+
+    Usage:
+        LevelAnalyzer [-j <threads>] [-r] <level directory or file>...
+
+        -j <threads>    Number of worker threads (defaults to the number of hardware threads)
+        -r              Search directories recursively
+
+    Checks (errors - the level will not load or play correctly):
+        - Every row is exactly mapWidth characters and there are exactly mapHeight rows
+        - No byte order marks or unknown characters (Windows line endings are only a warning)
+        - Exactly one player spawn (P) and one door (D), neither on the score row
+        - No open cells on the map border (the player would walk straight off the map)
+        - The door and every floor cell can be reached from the spawn. Coins can be placed on any floor
+          cell, so a single unreachable cell can make a level impossible to finish
+
+    Stats:
+        - Door distance     Shortest number of moves from the spawn to the door
+        - Chokepoints       Floor cells which split the map in two if they were walls (articulation points)
+        - Dead ends         Floor cells with only one way in or out
+        - Corridor width    For each floor cell, the smaller of its horizontal and vertical run of floor
+
+    Only files named level<N>.txt are picked up from directories, as those are the only ones the game loads.
+    Anything else is listed under "ignoredFiles" in the directory's output. Files named directly on the
+    command line are always checked.
+
+    Output is one JSON object per line (one per level, then one per directory) on stdout, with a short summary
+    on stderr. The exit code is 1 if any level has errors, so it can be dropped straight into a script.
+*/
+
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <format>
+#include <array>
+#include <limits>
+#include <cmath>
+#include <utility>
+#include <set>
+
+#include "../Level.h"
+
+// Constant globals
+const int mapSize = mapWidth * mapHeight;
+
+// Stop reporting the same kind of problem after this many occurrences
+const int maxReportedPerCheck = 5;
+
+// Everything we found out about a single level file
+struct LevelReport
+{
+    std::filesystem::path file;
+    std::vector<std::string> errors;
+    std::vector<std::string> warnings;
+
+    // Only filled in when the level is the right shape to check its contents
+    bool contentsChecked = false;
+    int spawnCount = 0;
+    int doorCount = 0;
+
+    // Only filled in when there is exactly one spawn to search from
+    bool analysed = false;
+    int floorCells = 0;
+    int reachableCells = 0;
+    bool doorReachable = false;
+    int doorDistance = -1;
+    int chokepoints = 0;
+    int deadEnds = 0;
+    int minCorridorWidth = 0;
+    double meanCorridorWidth = 0.0;
+    int singleWidthCells = 0;
+};
+
+// Level numbering for a directory, to match what getNumLevels()/main() expect
+struct DirectoryReport
+{
+    std::filesystem::path directory;
+    int levelCount = 0;
+    std::vector<std::pair<int, int>> missingLevels;    // Gaps in the numbering as [from, to] ranges
+    std::vector<std::string> ignoredFiles;
+};
+
+/*
+    Function forward declarations
+*/
+// Level checking
+LevelReport analyseLevel(const std::filesystem::path& file);
+bool loadGrid(const std::string& contents, std::array<char, mapSize>& grid, LevelReport& report);
+void checkContents(const std::array<char, mapSize>& grid, int& spawnIndex, int& doorIndex, LevelReport& report);
+void checkReachability(const std::array<char, mapSize>& grid, int spawnIndex, int doorIndex, LevelReport& report);
+void findChokepoints(const std::array<char, mapSize>& grid, int spawnIndex, LevelReport& report);
+void measureCorridors(const std::array<char, mapSize>& grid, LevelReport& report);
+
+// Grid helpers
+bool isOpen(const std::array<char, mapSize>& grid, int x, int y);
+int getOpenNeighbours(const std::array<char, mapSize>& grid, int idx, std::array<int, 4>& neighbours);
+
+// Level discovery
+void findLevelFiles(const std::filesystem::path& path, bool recursive, std::vector<std::filesystem::path>& files, std::vector<DirectoryReport>& directories);
+
+// Output
+std::string toUtf8(const std::filesystem::path& path);
+std::string jsonEscape(const std::string& text);
+std::string describeChar(char c);
+std::string levelToJson(const LevelReport& report);
+std::string directoryToJson(const DirectoryReport& report);
+void printUsage();
+
+
+int main(int argc, char* argv[])
+{
+    unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    bool recursive = false;
+    std::vector<std::filesystem::path> inputs;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+        {
+            try
+            {
+                numThreads = std::max(1, std::stoi(argv[++i]));
+            }
+            catch (std::exception&)
+            {
+                printUsage();
+                return 2;
+            }
+        }
+        else if (arg == "-r")
+            recursive = true;
+        else if (arg == "-h" || arg == "--help")
+        {
+            printUsage();
+            return 0;
+        }
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty())
+    {
+        printUsage();
+        return 2;
+    }
+
+    // Gather every level file up front so the work can be split evenly between threads
+    std::vector<std::filesystem::path> files;
+    std::vector<DirectoryReport> directories;
+    for (const auto& input : inputs)
+    {
+        try
+        {
+            findLevelFiles(input, recursive, files, directories);
+        }
+        catch (std::filesystem::filesystem_error& e)
+        {
+            std::cerr << "Failed to read: " << toUtf8(input) << std::endl;
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 2;
+        }
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    /*
+        Each worker grabs the next unclaimed file until there are none left. Levels are tiny and
+        independent of each other, so there's nothing to share between workers apart from the counter.
+        Results go into their own slot so the output comes out in the same order every run.
+    */
+    std::vector<LevelReport> reports(files.size());
+    std::atomic<size_t> nextFile = 0;
+    auto worker = [&]()
+    {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+            reports[i] = analyseLevel(files[i]);
+    };
+
+    numThreads = (unsigned int)std::min<size_t>(numThreads, std::max<size_t>(1, files.size()));
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < numThreads; i++)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread& t : workers)
+        t.join();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    // Write everything out in one go rather than flushing per level
+    std::string output;
+    int failedLevels = 0;
+    for (const LevelReport& report : reports)
+    {
+        output += levelToJson(report);
+        output += '\n';
+        if (!report.errors.empty())
+            failedLevels++;
+    }
+    for (const DirectoryReport& report : directories)
+    {
+        output += directoryToJson(report);
+        output += '\n';
+    }
+    std::cout << output << std::flush;
+
+    std::cerr << std::format("Analysed {} level(s) in {}ms using {} thread(s): {} ok, {} with errors",
+        reports.size(), elapsed.count(), numThreads, reports.size() - failedLevels, failedLevels) << std::endl;
+
+    return failedLevels > 0 ? 1 : 0;
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: LevelAnalyzer [-j <threads>] [-r] <level directory or file>..." << std::endl;
+    std::cerr << "  -j <threads>  Number of worker threads (default: hardware threads)" << std::endl;
+    std::cerr << "  -r            Search directories recursively" << std::endl;
+}
+
+LevelReport analyseLevel(const std::filesystem::path& file)
+{
+    LevelReport report;
+    report.file = file;
+
+    // Read the raw bytes so we can see exactly what initMap() would be given
+    std::ifstream levelFile(file, std::ios::binary);
+    if (!levelFile.is_open())
+    {
+        report.errors.push_back("Failed to open file");
+        return report;
+    }
+    std::string contents((std::istreambuf_iterator<char>(levelFile)), std::istreambuf_iterator<char>());
+
+    std::array<char, mapSize> grid;
+    if (!loadGrid(contents, grid, report))
+        return report;
+
+    int spawnIndex = -1;
+    int doorIndex = -1;
+    checkContents(grid, spawnIndex, doorIndex, report);
+
+    // Without exactly one spawn there's nowhere sensible to search from
+    if (report.spawnCount != 1)
+        return report;
+
+    report.analysed = true;
+    checkReachability(grid, spawnIndex, doorIndex, report);
+    findChokepoints(grid, spawnIndex, report);
+    measureCorridors(grid, report);
+
+    return report;
+}
+
+bool loadGrid(const std::string& contents, std::array<char, mapSize>& grid, LevelReport& report)
+{
+    /*
+        Splits the file into rows the same way std::getline() does in initMap() (blank lines add nothing), and checks
+        that they would line up with mapWidth/mapHeight once concatenated.
+
+        Returns false if the level is the wrong shape, as nothing after this point makes sense
+        if the rows don't line up.
+    */
+
+    size_t start = 0;
+    if (contents.compare(0, 3, "\xEF\xBB\xBF") == 0)
+    {
+        report.errors.push_back("File starts with a UTF-8 byte order mark, which would be loaded as part of the first row");
+        start = 3;
+    }
+
+    std::vector<std::string> rows;
+    while (start < contents.size())
+    {
+        size_t end = contents.find('\n', start);
+        if (end == std::string::npos)
+            end = contents.size();
+        rows.push_back(contents.substr(start, end - start));
+        start = end + 1;
+    }
+
+    /*
+        Windows line endings are fine for the game, initMap() opens the file in text mode which strips the
+        '\r' before each '\n'. They'd only end up in the map if the level was loaded in binary mode or on
+        another platform, so that's just a warning. A '\r' anywhere else in a row survives text mode and
+        is caught below as the row being the wrong width.
+    */
+    int crRows = 0;
+    for (std::string& row : rows)
+    {
+        if (!row.empty() && row.back() == '\r')
+        {
+            row.pop_back();
+            crRows++;
+        }
+    }
+    if (crRows > 0)
+        report.warnings.push_back(std::format("{} row(s) end with a carriage return (Windows line endings), this will break if loaded in binary mode or on non-Windows", crRows));
+
+    // initMap() appends blank lines as nothing, so they don't affect the level. Row numbers below are map rows
+    size_t rowCount = rows.size();
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [](const std::string& row) { return row.empty(); }), rows.end());
+    if (rows.size() != rowCount)
+        report.warnings.push_back(std::format("{} blank line(s), these are skipped when the level is loaded", rowCount - rows.size()));
+
+    bool rightShape = true;
+    if ((int)rows.size() != mapHeight)
+    {
+        report.errors.push_back(std::format("Level has {} rows, expected {}", rows.size(), mapHeight));
+        rightShape = false;
+    }
+
+    int badRows = 0;
+    for (size_t y = 0; y < rows.size(); y++)
+    {
+        if ((int)rows[y].size() != mapWidth)
+        {
+            if (badRows < maxReportedPerCheck)
+                report.errors.push_back(std::format("Row {} is {} characters wide, expected {}", y, rows[y].size(), mapWidth));
+            badRows++;
+            rightShape = false;
+        }
+    }
+    if (badRows > maxReportedPerCheck)
+        report.errors.push_back(std::format("{} more row(s) are the wrong width", badRows - maxReportedPerCheck));
+
+    if (!rightShape)
+        return false;
+
+    for (int y = 0; y < mapHeight; y++)
+        std::copy(rows[y].begin(), rows[y].end(), grid.begin() + y * mapWidth);
+
+    return true;
+}
+
+void checkContents(const std::array<char, mapSize>& grid, int& spawnIndex, int& doorIndex, LevelReport& report)
+{
+    /*
+        Checks every cell holds something the game knows how to draw, finds the spawn and door, and
+        makes sure the border is sealed. handlePlayerMovement() has no bounds checks of its own, it
+        relies on the level being surrounded by walls.
+    */
+
+    report.contentsChecked = true;
+    int unknownChars = 0;
+    int openBorderCells = 0;
+
+    for (int i = 0; i < mapSize; i++)
+    {
+        char c = grid[i];
+        int x = i % mapWidth;
+        int y = i / mapWidth;
+
+        if (c == LEVEL_PLAYER_SPAWN)
+        {
+            spawnIndex = i;
+            report.spawnCount++;
+            if (y == 0)
+                report.errors.push_back(std::format("Player spawn at ({}, {}) is on the score row", x, y));
+        }
+        else if (c == LEVEL_DOOR)
+        {
+            doorIndex = i;
+            report.doorCount++;
+            if (y == 0)
+                report.errors.push_back(std::format("Door at ({}, {}) is on the score row", x, y));
+            else if (x != 0 && x != mapWidth - 1 && y != 1 && y != mapHeight - 1)
+                report.warnings.push_back(std::format("Door at ({}, {}) is not on the edge of the map", x, y));
+        }
+        else if (c != LEVEL_WALL && c != LEVEL_FLOOR)
+        {
+            if (unknownChars < maxReportedPerCheck)
+                report.errors.push_back(std::format("Unexpected character {} at ({}, {})", describeChar(c), x, y));
+            unknownChars++;
+        }
+
+        // The score row is drawn over in-game, so only the play area needs a sealed border
+        bool onBorder = y == 1 || y == mapHeight - 1 || x == 0 || x == mapWidth - 1;
+        if (y > 0 && onBorder && c != LEVEL_WALL && c != LEVEL_DOOR)
+        {
+            if (openBorderCells < maxReportedPerCheck)
+                report.errors.push_back(std::format("Open cell on the map border at ({}, {})", x, y));
+            openBorderCells++;
+        }
+    }
+
+    if (unknownChars > maxReportedPerCheck)
+        report.errors.push_back(std::format("{} more unexpected character(s)", unknownChars - maxReportedPerCheck));
+    if (openBorderCells > maxReportedPerCheck)
+        report.errors.push_back(std::format("{} more open border cell(s)", openBorderCells - maxReportedPerCheck));
+
+    // getPlayerPos() and getNextLevelDoorIndex() both silently take the last one they find
+    if (report.spawnCount == 0)
+        report.errors.push_back("No player spawn (P)");
+    else if (report.spawnCount > 1)
+        report.errors.push_back(std::format("{} player spawns (P), expected 1", report.spawnCount));
+
+    if (report.doorCount == 0)
+        report.errors.push_back("No door to the next level (D)");
+    else if (report.doorCount > 1)
+        report.errors.push_back(std::format("{} doors (D), expected 1", report.doorCount));
+}
+
+bool isOpen(const std::array<char, mapSize>& grid, int x, int y)
+{
+    // Anything that isn't a wall can be walked on. The door counts as a wall here, as the
+    // player leaves the level as soon as they step through it
+    if (x < 0 || x >= mapWidth || y < 1 || y >= mapHeight)
+        return false;
+    char c = grid[y * mapWidth + x];
+    return c != LEVEL_WALL && c != LEVEL_DOOR;
+}
+
+int getOpenNeighbours(const std::array<char, mapSize>& grid, int idx, std::array<int, 4>& neighbours)
+{
+    int x = idx % mapWidth;
+    int y = idx / mapWidth;
+    int count = 0;
+
+    if (isOpen(grid, x - 1, y))     neighbours[count++] = idx - 1;
+    if (isOpen(grid, x + 1, y))     neighbours[count++] = idx + 1;
+    if (isOpen(grid, x, y - 1))     neighbours[count++] = idx - mapWidth;
+    if (isOpen(grid, x, y + 1))     neighbours[count++] = idx + mapWidth;
+
+    return count;
+}
+
+void checkReachability(const std::array<char, mapSize>& grid, int spawnIndex, int doorIndex, LevelReport& report)
+{
+    /*
+        Breadth first search out from the spawn point. Gives us the shortest route to the door,
+        and any floor cell we never visit is somewhere a coin could be placed but never collected.
+    */
+
+    std::array<int, mapSize> distance;
+    distance.fill(-1);
+    std::vector<int> queue;
+    queue.reserve(mapSize);
+
+    distance[spawnIndex] = 0;
+    queue.push_back(spawnIndex);
+    std::array<int, 4> neighbours;
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int current = queue[head];
+        int count = getOpenNeighbours(grid, current, neighbours);
+        for (int n = 0; n < count; n++)
+        {
+            if (distance[neighbours[n]] == -1)
+            {
+                distance[neighbours[n]] = distance[current] + 1;
+                queue.push_back(neighbours[n]);
+            }
+        }
+
+        // The door only needs to be next to somewhere we can reach
+        if (doorIndex != -1)
+        {
+            int x = current % mapWidth;
+            int y = current / mapWidth;
+            int doorX = doorIndex % mapWidth;
+            int doorY = doorIndex / mapWidth;
+            if (std::abs(x - doorX) + std::abs(y - doorY) == 1 && !report.doorReachable)
+            {
+                report.doorReachable = true;
+                report.doorDistance = distance[current] + 1;
+            }
+        }
+    }
+
+    report.reachableCells = (int)queue.size();
+    for (int i = mapWidth; i < mapSize; i++)
+        if (isOpen(grid, i % mapWidth, i / mapWidth))
+            report.floorCells++;
+
+    if (report.doorCount == 1 && !report.doorReachable)
+        report.errors.push_back("Door cannot be reached from the player spawn");
+
+    int unreachable = report.floorCells - report.reachableCells;
+    if (unreachable > 0)
+    {
+        // Point at the first one so it's easy to find in the file
+        int first = mapWidth;
+        while (!isOpen(grid, first % mapWidth, first / mapWidth) || distance[first] != -1)
+            first++;
+        report.errors.push_back(std::format("{} floor cell(s) cannot be reached from the player spawn, first at ({}, {})",
+            unreachable, first % mapWidth, first / mapWidth));
+    }
+}
+
+void findChokepoints(const std::array<char, mapSize>& grid, int spawnIndex, LevelReport& report)
+{
+    /*
+        Finds articulation points in the floor reachable from the spawn (Tarjan's algorithm). Done with
+        an explicit stack rather than recursion, as a long winding corridor can go a few hundred cells deep.
+
+        discovery[i]    Order in which cell i was first visited
+        low[i]          Earliest discovered cell reachable from i's subtree using one back edge
+    */
+
+    std::array<int, mapSize> discovery;
+    std::array<int, mapSize> low;
+    std::array<int, mapSize> parent;
+    std::array<bool, mapSize> isChokepoint;
+    discovery.fill(-1);
+    isChokepoint.fill(false);
+
+    struct Frame
+    {
+        int idx;
+        int nextNeighbour;
+        int numNeighbours;
+        std::array<int, 4> neighbours;
+    };
+    std::vector<Frame> stack;
+    stack.reserve(mapSize);
+
+    int time = 0;
+    int rootChildren = 0;
+
+    Frame root = { spawnIndex, 0, 0, {} };
+    root.numNeighbours = getOpenNeighbours(grid, spawnIndex, root.neighbours);
+    discovery[spawnIndex] = low[spawnIndex] = time++;
+    parent[spawnIndex] = -1;
+    stack.push_back(root);
+
+    while (!stack.empty())
+    {
+        Frame& frame = stack.back();
+        int current = frame.idx;
+
+        if (frame.nextNeighbour < frame.numNeighbours)
+        {
+            int next = frame.neighbours[frame.nextNeighbour++];
+            if (discovery[next] == -1)
+            {
+                parent[next] = current;
+                discovery[next] = low[next] = time++;
+                if (current == spawnIndex)
+                    rootChildren++;
+
+                Frame child = { next, 0, 0, {} };
+                child.numNeighbours = getOpenNeighbours(grid, next, child.neighbours);
+                stack.push_back(child); // frame is invalid after this point
+            }
+            else if (next != parent[current])
+                low[current] = std::min(low[current], discovery[next]);
+        }
+        else
+        {
+            // Finished with this cell, pass its low value back up to its parent
+            stack.pop_back();
+            int up = parent[current];
+            if (up != -1)
+            {
+                low[up] = std::min(low[up], low[current]);
+                if (up != spawnIndex && low[current] >= discovery[up])
+                    isChokepoint[up] = true;
+            }
+        }
+    }
+
+    // The root is only a chokepoint if the search had to leave it more than once
+    if (rootChildren > 1)
+        isChokepoint[spawnIndex] = true;
+
+    std::array<int, 4> neighbours;
+    for (int i = 0; i < mapSize; i++)
+    {
+        if (isChokepoint[i])
+            report.chokepoints++;
+        if (discovery[i] != -1 && getOpenNeighbours(grid, i, neighbours) == 1)
+            report.deadEnds++;
+    }
+}
+
+void measureCorridors(const std::array<char, mapSize>& grid, LevelReport& report)
+{
+    /*
+        Corridor width at a cell is the shorter of the horizontal and vertical runs of floor through it.
+        A 1 wide corridor is where enemies can easily trap the player, open rooms score much higher.
+
+        Runs are worked out in two passes over the grid rather than walking out from every cell.
+    */
+
+    std::array<int, mapSize> horizontal;
+    std::array<int, mapSize> vertical;
+    horizontal.fill(0);
+    vertical.fill(0);
+
+    for (int y = 1; y < mapHeight; y++)
+    {
+        int x = 0;
+        while (x < mapWidth)
+        {
+            int runStart = x;
+            while (x < mapWidth && isOpen(grid, x, y))
+                x++;
+            for (int i = runStart; i < x; i++)
+                horizontal[y * mapWidth + i] = x - runStart;
+            x++;
+        }
+    }
+
+    for (int x = 0; x < mapWidth; x++)
+    {
+        int y = 1;
+        while (y < mapHeight)
+        {
+            int runStart = y;
+            while (y < mapHeight && isOpen(grid, x, y))
+                y++;
+            for (int i = runStart; i < y; i++)
+                vertical[i * mapWidth + x] = y - runStart;
+            y++;
+        }
+    }
+
+    long long totalWidth = 0;
+    int counted = 0;
+    report.minCorridorWidth = std::numeric_limits<int>::max();
+    for (int i = mapWidth; i < mapSize; i++)
+    {
+        if (!isOpen(grid, i % mapWidth, i / mapWidth))
+            continue;
+
+        int width = std::min(horizontal[i], vertical[i]);
+        report.minCorridorWidth = std::min(report.minCorridorWidth, width);
+        if (width == 1)
+            report.singleWidthCells++;
+        totalWidth += width;
+        counted++;
+    }
+
+    if (counted == 0)
+        report.minCorridorWidth = 0;
+    else
+        report.meanCorridorWidth = (double)totalWidth / counted;
+}
+
+void findLevelFiles(const std::filesystem::path& path, bool recursive, std::vector<std::filesystem::path>& files, std::vector<DirectoryReport>& directories)
+{
+    // Files named on the command line are always analysed, whatever they're called
+    if (!std::filesystem::is_directory(path))
+    {
+        files.push_back(path);
+        return;
+    }
+
+    // Collect this directory's files first and sort them so the output order is stable
+    std::vector<std::filesystem::path> entries;
+    std::vector<std::filesystem::path> subdirectories;
+    for (const auto& entry : std::filesystem::directory_iterator(path))
+    {
+        if (entry.is_regular_file())
+            entries.push_back(entry.path());
+        else if (recursive && entry.is_directory())
+            subdirectories.push_back(entry.path());
+    }
+    std::sort(entries.begin(), entries.end());
+    std::sort(subdirectories.begin(), subdirectories.end());
+
+    /*
+        Only level<N>.txt files are analysed, the same as getNumLevels(). Anything else (a README, the
+        level template...) is never loaded by the game, so it's just listed as ignored.
+
+        The game loads level0.txt, level1.txt... in order, so a gap in the numbering stops it short.
+    */
+    DirectoryReport report;
+    report.directory = path;
+    std::set<int> levelNumbers;
+    for (const auto& entry : entries)
+    {
+        int levelNumber;
+        if (isLevelFileName(entry, levelNumber))
+        {
+            levelNumbers.insert(levelNumber);
+            files.push_back(entry);
+        }
+        else
+            report.ignoredFiles.push_back(toUtf8(entry.filename()));
+    }
+
+    // Gaps are stored as ranges, so one level9999999.txt doesn't produce millions of entries
+    report.levelCount = (int)levelNumbers.size();
+    int expected = 0;
+    for (int levelNumber : levelNumbers)
+    {
+        if (levelNumber > expected)
+            report.missingLevels.push_back({ expected, levelNumber - 1 });
+        expected = levelNumber + 1;
+    }
+    directories.push_back(report);
+
+    for (const auto& subdirectory : subdirectories)
+        findLevelFiles(subdirectory, recursive, files, directories);
+}
+
+std::string describeChar(char c)
+{
+    if (c >= 0x20 && c < 0x7F)
+        return std::format("'{}'", c);
+    return std::format("0x{:02X}", (unsigned char)c);
+}
+
+std::string toUtf8(const std::filesystem::path& path)
+{
+    // string() throws on Windows for names that don't fit in the ANSI code page, UTF-8 always works
+    std::u8string text = path.generic_u8string();
+    return std::string(text.begin(), text.end());
+}
+
+std::string jsonEscape(const std::string& text)
+{
+    std::string escaped = "\"";
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':   escaped += "\\\"";  break;
+        case '\\':  escaped += "\\\\";  break;
+        case '\n':  escaped += "\\n";   break;
+        case '\r':  escaped += "\\r";   break;
+        case '\t':  escaped += "\\t";   break;
+        default:
+            if ((unsigned char)c < 0x20)
+                escaped += std::format("\\u{:04x}", (unsigned char)c);
+            else
+                escaped += c;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+std::string levelToJson(const LevelReport& report)
+{
+    auto toList = [](const std::vector<std::string>& items)
+    {
+        std::string list = "[";
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            if (i > 0)
+                list += ',';
+            list += jsonEscape(items[i]);
+        }
+        return list + "]";
+    };
+
+    std::string json = std::format("{{\"type\":\"level\",\"file\":{},\"valid\":{},\"errors\":{},\"warnings\":{}",
+        jsonEscape(toUtf8(report.file)), report.errors.empty() ? "true" : "false",
+        toList(report.errors), toList(report.warnings));
+
+    if (report.contentsChecked)
+        json += std::format(",\"spawns\":{},\"doors\":{}", report.spawnCount, report.doorCount);
+
+    if (report.analysed)
+    {
+        json += std::format(",\"floorCells\":{},\"reachableCells\":{},\"doorReachable\":{},\"doorDistance\":{}",
+            report.floorCells, report.reachableCells, report.doorReachable ? "true" : "false",
+            report.doorReachable ? std::to_string(report.doorDistance) : "null");
+        json += std::format(",\"chokepoints\":{},\"deadEnds\":{},\"minCorridorWidth\":{},\"meanCorridorWidth\":{:.2f},\"singleWidthCells\":{}",
+            report.chokepoints, report.deadEnds, report.minCorridorWidth, report.meanCorridorWidth, report.singleWidthCells);
+    }
+
+    return json + "}";
+}
+
+std::string directoryToJson(const DirectoryReport& report)
+{
+    std::string missing = "[";
+    for (size_t i = 0; i < report.missingLevels.size(); i++)
+    {
+        if (i > 0)
+            missing += ',';
+        missing += std::format("[{},{}]", report.missingLevels[i].first, report.missingLevels[i].second);
+    }
+    missing += "]";
+
+    std::string ignored = "[";
+    for (size_t i = 0; i < report.ignoredFiles.size(); i++)
+    {
+        if (i > 0)
+            ignored += ',';
+        ignored += jsonEscape(report.ignoredFiles[i]);
+    }
+    ignored += "]";
+
+    return std::format("{{\"type\":\"directory\",\"directory\":{},\"levelCount\":{},\"missingLevels\":{},\"ignoredFiles\":{}}}",
+        jsonEscape(toUtf8(report.directory)), report.levelCount, missing, ignored);
+}
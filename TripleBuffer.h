@@ -0,0 +1,90 @@
+/*
+    Hands finished frames from the game loop over to the render thread without either side waiting
+    on the other. Kept in its own header so it can be tested without the console.
+*/
+
+#pragma once
+
+#include <atomic>
+
+#include "Level.h"
+
+// A complete frame (map plus score row), ready to be written to the console
+struct Frame
+{
+    wchar_t cells[mapWidth * mapHeight];
+};
+
+/*
+    Triple buffer for passing frames from the game loop to the render thread.
+
+    There are three frames: one the game is writing, one the renderer is drawing, and a spare holding the
+    latest finished frame. Publishing and acquiring just swap a frame with the spare, so neither side ever
+    waits on the other. 'state' holds the index of the spare frame, plus a flag saying whether it's a new
+    frame the renderer hasn't seen yet.
+*/
+struct TripleBuffer
+{
+    static const unsigned int indexMask = 0x3;
+    static const unsigned int newFrameFlag = 0x4;
+    static const unsigned int stopFlag = 0x8;
+
+    Frame frames[3];
+    std::atomic<unsigned int> state = 1;
+    int writeIndex = 0;     // Only touched by the game loop
+    int readIndex = 2;      // Only touched by the render thread
+
+    std::atomic<unsigned long long> presentedFrames = 0;
+    std::atomic<unsigned long long> droppedFrames = 0;
+
+    Frame& getWriteFrame()
+    {
+        return frames[writeIndex];
+    }
+
+    // Game loop: swap the finished frame in as the spare. Never blocks
+    void publish()
+    {
+        unsigned int previous = state.exchange(writeIndex | newFrameFlag);
+        writeIndex = previous & indexMask;
+
+        // The renderer never picked up the frame we just replaced
+        if (previous & newFrameFlag)
+            droppedFrames++;
+
+        state.notify_one();
+    }
+
+    // Render thread: wait for a new frame and swap it in. Returns false once stop() has been called
+    bool acquire()
+    {
+        unsigned int current = state.load();
+        while (!(current & (newFrameFlag | stopFlag)))
+        {
+            state.wait(current);
+            current = state.load();
+        }
+
+        if (current & stopFlag)
+            return false;
+
+        // Swap our frame in as the spare. stop() can land at any point, so keep its flag rather than overwriting it
+        while (!state.compare_exchange_weak(current, readIndex | (current & stopFlag)))
+        {
+        }
+        readIndex = current & indexMask;
+        return true;
+    }
+
+    const Frame& getReadFrame()
+    {
+        return frames[readIndex];
+    }
+
+    // Game loop: tell the render thread to finish up
+    void stop()
+    {
+        state.fetch_or(stopFlag);
+        state.notify_one();
+    }
+};
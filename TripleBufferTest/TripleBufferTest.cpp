@@ -0,0 +1,193 @@
+/*
+    Endless PacMan Triple Buffer Test
+
+    Checks that a slow console can't slow the game down. Runs the same loop as main() - build a frame,
+    publish it, sleep until the next tick - against a fake render thread that takes 0, 50 and 200ms to
+    draw each frame, and checks that:
+
+        - The ticks take the same time however slow the renderer is
+        - The renderer never draws an older frame after a newer one
+        - Every frame is either drawn or counted as skipped
+        - stop() always wakes the render thread, even while it's busy drawing
+
+    Prints the results for each run and returns 1 if anything failed.
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <format>
+#include <cstdlib>
+
+#include "../TripleBuffer.h"
+
+// Matches the Sleep(50) in main(), scaled down so the test doesn't take forever
+const int tickMs = 10;
+const int numTicks = 100;
+
+// Allowed slowdown compared to a renderer that takes no time at all
+const double tickTolerance = 1.2;
+const double tickToleranceMs = 20.0;
+
+struct TickResult
+{
+    double totalMs = 0.0;
+    double worstPublishMs = 0.0;
+    unsigned long long presented = 0;
+    unsigned long long dropped = 0;
+    bool wentBackwards = false;
+};
+
+/*
+    Function forward declarations
+*/
+TickResult runTicks(int sinkDelayMs);
+bool checkTicks(int sinkDelayMs, const TickResult& result, const TickResult& baseline);
+bool checkStop();
+
+
+int main()
+{
+    bool passed = true;
+
+    TickResult baseline = runTicks(0);
+    passed &= checkTicks(0, baseline, baseline);
+
+    for (int sinkDelayMs : { 50, 200 })
+        passed &= checkTicks(sinkDelayMs, runTicks(sinkDelayMs), baseline);
+
+    passed &= checkStop();
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
+
+TickResult runTicks(int sinkDelayMs)
+{
+    TickResult result;
+    TripleBuffer frameBuffer;
+
+    // Stand-in for renderLoop(), with the console write replaced by a sleep
+    std::thread renderThread([&]()
+    {
+        wchar_t lastTick = 0;
+        while (frameBuffer.acquire())
+        {
+            wchar_t tick = frameBuffer.getReadFrame().cells[0];
+            if (tick < lastTick)
+                result.wentBackwards = true;
+            lastTick = tick;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(sinkDelayMs));
+            frameBuffer.presentedFrames++;
+        }
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (int tick = 1; tick <= numTicks; tick++)
+    {
+        // Stamp every cell with the tick number so the renderer can tell which frame it got
+        Frame& frame = frameBuffer.getWriteFrame();
+        std::fill(std::begin(frame.cells), std::end(frame.cells), (wchar_t)tick);
+
+        auto publishStart = std::chrono::steady_clock::now();
+        frameBuffer.publish();
+        double publishMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - publishStart).count();
+        result.worstPublishMs = std::max(result.worstPublishMs, publishMs);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(tickMs));
+    }
+    result.totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    frameBuffer.stop();
+    renderThread.join();
+
+    result.presented = frameBuffer.presentedFrames;
+    result.dropped = frameBuffer.droppedFrames;
+    return result;
+}
+
+bool checkTicks(int sinkDelayMs, const TickResult& result, const TickResult& baseline)
+{
+    bool passed = true;
+    double allowedMs = baseline.totalMs * tickTolerance + tickToleranceMs;
+
+    std::cout << std::format("Render delay {:3}ms: {} ticks in {:.0f}ms (allowed {:.0f}ms), worst publish {:.3f}ms, {} drawn, {} skipped",
+        sinkDelayMs, numTicks, result.totalMs, allowedMs, result.worstPublishMs, result.presented, result.dropped) << std::endl;
+
+    if (result.totalMs > allowedMs)
+    {
+        std::cout << "  Ticks were slowed down by the renderer" << std::endl;
+        passed = false;
+    }
+
+    if (result.wentBackwards)
+    {
+        std::cout << "  Renderer drew an older frame after a newer one" << std::endl;
+        passed = false;
+    }
+
+    // The very last frame may still be waiting when stop() is called, every other one is drawn or skipped
+    unsigned long long accountedFor = result.presented + result.dropped;
+    if (accountedFor > (unsigned long long)numTicks || accountedFor + 1 < (unsigned long long)numTicks)
+    {
+        std::cout << std::format("  {} frames drawn or skipped, expected {}", accountedFor, numTicks) << std::endl;
+        passed = false;
+    }
+
+    // A renderer this slow can't keep up, so it has to be skipping frames rather than queueing them
+    if (sinkDelayMs > tickMs && result.dropped == 0)
+    {
+        std::cout << "  Renderer is slower than the game but no frames were skipped" << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool checkStop()
+{
+    /*
+        Calls stop() while the render thread is part way through picking up a frame, over and over.
+        If a stop request ever gets lost the render thread waits forever, so this runs on its own
+        thread and we give up on it after a while rather than hanging the test.
+    */
+    const int rounds = 500;
+    std::atomic<bool> finished = false;
+
+    std::thread stopThread([&]()
+    {
+        for (int round = 0; round < rounds; round++)
+        {
+            TripleBuffer frameBuffer;
+            std::thread renderThread([&]()
+            {
+                while (frameBuffer.acquire())
+                    frameBuffer.presentedFrames++;
+            });
+
+            frameBuffer.publish();
+            std::this_thread::sleep_for(std::chrono::microseconds(round % 50));
+            frameBuffer.stop();
+            renderThread.join();
+        }
+        finished = true;
+    });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!finished && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    if (!finished)
+    {
+        std::cout << "Stop: render thread never finished, stop request was lost" << std::endl;
+        std::cout << "FAILED" << std::endl;
+        std::_Exit(1); // The stuck thread can't be joined
+    }
+
+    stopThread.join();
+    std::cout << std::format("Stop: render thread finished every time over {} rounds", rounds) << std::endl;
+    return true;
+}
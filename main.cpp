@@ -8,6 +8,11 @@
         and coins. This path is updated every time the handleEnemyMovement() function is called. This takes a lot of
         calculation and is likely the slowest part of the program. Especially with how frequently it runs. Might try to
         optimise this a bit if possible.
+
+    Rendering:
+        Drawing happens on its own thread so a slow terminal can't slow the game down. Each tick the game loop
+        builds a complete frame and hands it over through a triple buffer. The game loop never waits on the
+        renderer, and the renderer always draws the newest frame, skipping any it didn't get to in time.
 */
 
 #include <Windows.h>
@@ -29,9 +34,8 @@
 #include <set>
 #include <map>
 
-// Constant globals
-const int mapWidth = 30;
-const int mapHeight = 31;
+#include "Level.h"
+#include "TripleBuffer.h"
 
 // Struct to represent a point on the map (for the pathfinding algo)
 struct Point 
@@ -56,10 +60,10 @@ enum Char : wchar_t
     PLAYER_RIGHT        = L'►',
     ENEMY               = L'X',
     COIN                = L'O',
-    WALL                = L'#',
-    FLOOR               = L' ',
-    PLAYER_PLACEHOLDER  = L'P',
-    NEXT_LEVEL_DOOR     = L'D'
+    WALL                = LEVEL_WALL,
+    FLOOR               = LEVEL_FLOOR,
+    PLAYER_PLACEHOLDER  = LEVEL_PLAYER_SPAWN,
+    NEXT_LEVEL_DOOR     = LEVEL_DOOR
 };
 
 // Difficulty
@@ -115,8 +119,10 @@ std::vector<Point> getNeighbours(Point p, std::wstring& map);
 std::vector<Point> aStar(Point start, Point goal, std::wstring& map);
 
 // Drawing Functions
-void drawMap(std::wstring& map, wchar_t* screen, HANDLE& hConsole, int& playerScore, int& currentCoins, int& currentLevel, int& numLevels);
-void displayScore(int currentLevel, int numLevels, int playerScore);
+void buildFrame(std::wstring& map, Frame& frame, int& playerScore, int& currentCoins, int& currentLevel, int& numLevels);
+void drawFrame(const Frame& frame, HANDLE& hConsole);
+void renderLoop(TripleBuffer& frameBuffer, HANDLE hConsole);
+void displayScore(int currentLevel, int numLevels, int playerScore, TripleBuffer& frameBuffer);
 
 // Level loading
 std::wstring initMap(std::string fileName);
@@ -157,11 +163,14 @@ int main()
         Get a handle to the console
         Get console buffer info
         Set console buffer size (map height and width)
+        Start the render thread drawing to it
     */
-    wchar_t* screen = new wchar_t[mapWidth * mapHeight * 2];
     HANDLE hConsole = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE, 0, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
     SetConsoleActiveScreenBuffer(hConsole);
 
+    TripleBuffer frameBuffer;
+    std::thread renderThread(renderLoop, std::ref(frameBuffer), hConsole);
+
     // Set enemy delay based on difficulty
     int delay;
     switch (difficulty)
@@ -200,8 +209,9 @@ int main()
 
         currentCoins = getCurrentCoins(map);
 
-        // Draw the map to the screen buffer
-        drawMap(map, screen, hConsole, playerScore, currentCoins, currentLevel, numLevels);
+        // Hand the current state of the map over to the render thread
+        buildFrame(map, frameBuffer.getWriteFrame(), playerScore, currentCoins, currentLevel, numLevels);
+        frameBuffer.publish();
 
         // Handle player movement
         playerPreviousIndex = playerCurrentIndex;
@@ -274,8 +284,12 @@ int main()
         Sleep(50);
     }
 
+    // Wait for the renderer to finish its last frame before writing anything else to the console
+    frameBuffer.stop();
+    renderThread.join();
+
     // End screen
-    displayScore(currentLevel, numLevels, playerScore);
+    displayScore(currentLevel, numLevels, playerScore, frameBuffer);
 
     return 0;
 }
@@ -300,12 +314,14 @@ void clearDoor(std::wstring& map, int& nextLevelDoorIndex)
     map[nextLevelDoorIndex] = floorChar;
 }
 
-void displayScore(int currentLevel, int numLevels, int playerScore)
+void displayScore(int currentLevel, int numLevels, int playerScore, TripleBuffer& frameBuffer)
 {
     std::cout << "********** GAME OVER **********" << std::endl;
     std::cout << "\nYour Score:" << std::endl;
     std::cout << "Levels played:   " << currentLevel << "/" << numLevels << std::endl;
     std::cout << "Coins collected: " << playerScore << std::endl;
+    std::cout << "\nFrames drawn:    " << frameBuffer.presentedFrames << std::endl;
+    std::cout << "Frames skipped:  " << frameBuffer.droppedFrames << std::endl;
     std::cout << "\n******************************" << std::endl;
     std::cout << "Thanks for playing!" << std::endl;
     _getch();
@@ -317,8 +333,10 @@ int getNumLevels(std::string levelDir)
 
     try
     {
+        // Only count files we would actually load (level<N>.txt), anything else in the directory is ignored
+        int levelNumber;
         for (const auto& entry : std::filesystem::directory_iterator(levelDir))
-            if (entry.is_regular_file())
+            if (entry.is_regular_file() && isLevelFileName(entry.path(), levelNumber))
                 levelCount++;
     }
     catch (std::filesystem::filesystem_error& e)
@@ -669,27 +687,45 @@ std::vector<int> coordConvert1T2(int idx)
     return xyVals;
 }
 
-void drawMap(std::wstring& map, wchar_t* screen, HANDLE& hConsole, int& playerScore, int& currentCoins, int& currentLevel, int& numLevels) 
+void buildFrame(std::wstring& map, Frame& frame, int& playerScore, int& currentCoins, int& currentLevel, int& numLevels)
 {
     const wchar_t* scoreString = L"Coins: %d Score: %d Level: %d/%d\0";
 
-    // Copy the map content line by line into the screen buffer
+    // Copy the map content line by line into the frame
     for (int y = 0; y < mapHeight; y++) {
         for (int x = 0; x < mapWidth; x++) {
-            screen[y * mapWidth + x] = map[y * mapWidth + x];
+            frame.cells[y * mapWidth + x] = map[y * mapWidth + x];
         }
     }
 
+    // Write the score over the top row, cutting it off at the edge of the map rather than spilling into the next row
+    wchar_t scoreBuffer[120];
+    int scoreLength = swprintf_s(scoreBuffer, 120, scoreString, currentCoins, playerScore, currentLevel, numLevels);
+    for (int x = 0; x < scoreLength && x < mapWidth; x++)
+        frame.cells[x] = scoreBuffer[x];
+}
+
+void drawFrame(const Frame& frame, HANDLE& hConsole)
+{
     // Write each line separately to the console
     DWORD dwBytesWritten = 0;
     COORD cursorPosition = { 0, 0 };  // Starting position
     for (short y = 0; y < (short)mapHeight; y++) {
-        if (y == 0)
-        {
-            // Write the score
-            swprintf_s(&screen[y * mapWidth], 120, scoreString, currentCoins, playerScore, currentLevel, numLevels);
-        }
-        WriteConsoleOutputCharacter(hConsole, &screen[y * mapWidth], mapWidth, cursorPosition, &dwBytesWritten);
+        WriteConsoleOutputCharacter(hConsole, &frame.cells[y * mapWidth], mapWidth, cursorPosition, &dwBytesWritten);
         cursorPosition.Y++; // Move to the next line
     }
 }
+
+void renderLoop(TripleBuffer& frameBuffer, HANDLE hConsole)
+{
+    /*
+        Runs on its own thread. Waits for the game loop to publish a frame then draws it. If the
+        console is slow, the game loop carries on regardless and we just draw whatever the latest
+        frame is once we're done with this one.
+    */
+    while (frameBuffer.acquire())
+    {
+        drawFrame(frameBuffer.getReadFrame(), hConsole);
+        frameBuffer.presentedFrames++;
+    }
+}